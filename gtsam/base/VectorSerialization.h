@@ -23,6 +23,7 @@
 #include <gtsam/base/Vector.h>
 
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_free.hpp>
 
@@ -65,4 +66,13 @@ BOOST_SERIALIZATION_SPLIT_FREE(gtsam::Vector)
 BOOST_SERIALIZATION_SPLIT_FREE(gtsam::Vector2)
 BOOST_SERIALIZATION_SPLIT_FREE(gtsam::Vector3)
 BOOST_SERIALIZATION_SPLIT_FREE(gtsam::Vector6)
+
+// The fixed-size vectors are flat arrays of doubles with no version or
+// pointer bookkeeping, so binary archives may copy them (and contiguous
+// collections of them, e.g. Point2Vector) as a single block of bytes
+// instead of visiting each coefficient. Text and XML archives still go
+// through the element-wise save/load above.
+BOOST_IS_BITWISE_SERIALIZABLE(gtsam::Vector2)
+BOOST_IS_BITWISE_SERIALIZABLE(gtsam::Vector3)
+BOOST_IS_BITWISE_SERIALIZABLE(gtsam::Vector6)
 #endif
@@ -10,6 +10,8 @@
 
 #include <gtsam/base/Lie.h>
 
+#include <type_traits>
+
 namespace gtsam {
 
 /// tag to assert a type is a vector space
@@ -81,6 +83,62 @@ struct VectorSpaceImpl {
   }
 
   /// @}
+
+  /// @name Branch-free group operations, Jacobians selected at compile time
+  /// @{
+
+  /// Compose with the Jacobian writes compiled in (WithJacobians == true) or
+  /// compiled out (false), instead of tested per call. Use these in tight
+  /// loops where every call (or no call) needs the Jacobians, so the per-call
+  /// `if (H)` branch of the overloads above vanishes. The Jacobian arguments
+  /// are required exactly when WithJacobians is true; a call that would write
+  /// through an absent Jacobian does not compile.
+  template <bool WithJacobians>
+  static Class ComposeImpl(const Class& v1, const Class& v2,
+      ChartJacobian H1, ChartJacobian H2) {
+    static_assert(WithJacobians, "use ComposeImpl<false>(v1, v2)");
+    *H1 = Jacobian::Identity();
+    *H2 = Jacobian::Identity();
+    return v1 + v2;
+  }
+  template <bool WithJacobians>
+  static Class ComposeImpl(const Class& v1, const Class& v2) {
+    static_assert(!WithJacobians,
+                  "ComposeImpl<true> requires both Jacobian arguments");
+    return v1 + v2;
+  }
+
+  /// Between, with the same compile-time Jacobian selection as ComposeImpl.
+  template <bool WithJacobians>
+  static Class BetweenImpl(const Class& v1, const Class& v2,
+      ChartJacobian H1, ChartJacobian H2) {
+    static_assert(WithJacobians, "use BetweenImpl<false>(v1, v2)");
+    *H1 = - Jacobian::Identity();
+    *H2 =   Jacobian::Identity();
+    return v2 - v1;
+  }
+  template <bool WithJacobians>
+  static Class BetweenImpl(const Class& v1, const Class& v2) {
+    static_assert(!WithJacobians,
+                  "BetweenImpl<true> requires both Jacobian arguments");
+    return v2 - v1;
+  }
+
+  /// Inverse, with the same compile-time Jacobian selection as ComposeImpl.
+  template <bool WithJacobians>
+  static Class InverseImpl(const Class& v, ChartJacobian H) {
+    static_assert(WithJacobians, "use InverseImpl<false>(v)");
+    *H = - Jacobian::Identity();
+    return -v;
+  }
+  template <bool WithJacobians>
+  static Class InverseImpl(const Class& v) {
+    static_assert(!WithJacobians,
+                  "InverseImpl<true> requires the Jacobian argument");
+    return -v;
+  }
+
+  /// @}
 };
 
 /// VectorSpaceTraits implementation for dynamic types.
@@ -315,9 +373,16 @@ struct traits<Eigen::Matrix<double, M, N, Options, MaxRows, MaxCols> > :
       ChartJacobian H1 = {}, ChartJacobian H2 = {}) {
     if (H1) (*H1) = -Jacobian::Identity();
     if (H2) (*H2) =  Jacobian::Identity();
-    TangentVector result;
-    Eigen::Map<Fixed>(result.data()) = other - origin;
-    return result;
+    // For vector shapes TangentVector and Fixed are the same type, so the
+    // difference can be evaluated straight into the return value instead of
+    // materializing a temporary and copying it out through a reshaping Map.
+    if constexpr (std::is_same<TangentVector, Fixed>::value) {
+      return other - origin;
+    } else {
+      TangentVector result;
+      Eigen::Map<Fixed>(result.data()) = other - origin;
+      return result;
+    }
   }
 
   static Fixed Retract(const Fixed& origin, const TangentVector& v,
@@ -332,16 +397,23 @@ struct traits<Eigen::Matrix<double, M, N, Options, MaxRows, MaxCols> > :
   /// @{
   static TangentVector Logmap(const Fixed& m, ChartJacobian H = {}) {
     if (H) *H = Jacobian::Identity();
-    TangentVector result;
-    Eigen::Map<Fixed>(result.data()) = m;
-    return result;
+    // Same-type shortcut as in Local: skip the reshaping Map round-trip.
+    if constexpr (std::is_same<TangentVector, Fixed>::value) {
+      return m;
+    } else {
+      TangentVector result;
+      Eigen::Map<Fixed>(result.data()) = m;
+      return result;
+    }
   }
 
   static Fixed Expmap(const TangentVector& v, ChartJacobian H = {}) {
-    Fixed m;
-    m.setZero();
     if (H) *H = Jacobian::Identity();
-    return m + Eigen::Map<const Fixed>(v.data());
+    if constexpr (std::is_same<TangentVector, Fixed>::value) {
+      return v;
+    } else {
+      return Eigen::Map<const Fixed>(v.data());
+    }
   }
   /// @}
 };
@@ -0,0 +1,178 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    simd.h
+ * @brief   Thin portable wrappers around SIMD intrinsics for batch kernels
+ * @author  Frank Dellaert
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// ISA tiers. On x86 the wide kernels are compiled per-function with the
+// target attribute and selected at runtime (see hasAVX2/hasAVX512F below),
+// so no special compile flags are needed and the binary still runs on older
+// CPUs. On AArch64, NEON is part of the baseline ISA and needs no dispatch.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GTSAM_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define GTSAM_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace gtsam {
+namespace simd {
+
+/// @name Runtime CPU feature checks (x86)
+/// @{
+
+/// True if the host CPU supports the 4-wide AVX2+FMA double kernels.
+inline bool hasAVX2() {
+#ifdef GTSAM_SIMD_X86
+  static const bool have =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return have;
+#else
+  return false;
+#endif
+}
+
+/// True if the host CPU supports the 8-wide AVX-512F double kernels.
+inline bool hasAVX512F() {
+#ifdef GTSAM_SIMD_X86
+  static const bool have = __builtin_cpu_supports("avx512f");
+  return have;
+#else
+  return false;
+#endif
+}
+
+/// @}
+
+#ifdef GTSAM_SIMD_X86
+
+/// @name 4-wide double lane (AVX2 + FMA), x86 only
+/// @{
+
+/// Four doubles in one ymm register.
+using Double4 = __m256d;
+
+/// Decorator for AVX2+FMA functions: compiled for that ISA regardless of the
+/// global flags, so they must only be called after a hasAVX2() check. Apply
+/// it to any kernel built from the wrappers below so they inline into it.
+#define GTSAM_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+#define GTSAM_SIMD_AVX2_INLINE \
+  __attribute__((target("avx2,fma"), always_inline)) inline
+
+GTSAM_SIMD_AVX2_INLINE Double4 load4(const double* p) {
+  return _mm256_loadu_pd(p);
+}
+GTSAM_SIMD_AVX2_INLINE Double4 set4(double x) { return _mm256_set1_pd(x); }
+GTSAM_SIMD_AVX2_INLINE Double4 add4(Double4 a, Double4 b) {
+  return _mm256_add_pd(a, b);
+}
+GTSAM_SIMD_AVX2_INLINE Double4 sub4(Double4 a, Double4 b) {
+  return _mm256_sub_pd(a, b);
+}
+GTSAM_SIMD_AVX2_INLINE Double4 mul4(Double4 a, Double4 b) {
+  return _mm256_mul_pd(a, b);
+}
+/// a*b + c in one instruction.
+GTSAM_SIMD_AVX2_INLINE Double4 fmadd4(Double4 a, Double4 b, Double4 c) {
+  return _mm256_fmadd_pd(a, b, c);
+}
+GTSAM_SIMD_AVX2_INLINE Double4 sqrt4(Double4 a) { return _mm256_sqrt_pd(a); }
+GTSAM_SIMD_AVX2_INLINE void store4(double* p, Double4 a) {
+  _mm256_storeu_pd(p, a);
+}
+
+/// @}
+
+/// @name 8-wide double lane (AVX-512F), x86 only
+/// @{
+
+/// Eight doubles in one zmm register.
+using Double8 = __m512d;
+
+/// Decorator for AVX-512F functions; as with AVX2, only call such kernels
+/// after a hasAVX512F() check.
+#define GTSAM_SIMD_TARGET_AVX512F __attribute__((target("avx512f")))
+
+#define GTSAM_SIMD_AVX512F_INLINE \
+  __attribute__((target("avx512f"), always_inline)) inline
+
+GTSAM_SIMD_AVX512F_INLINE Double8 load8(const double* p) {
+  return _mm512_loadu_pd(p);
+}
+GTSAM_SIMD_AVX512F_INLINE Double8 set8(double x) { return _mm512_set1_pd(x); }
+GTSAM_SIMD_AVX512F_INLINE Double8 add8(Double8 a, Double8 b) {
+  return _mm512_add_pd(a, b);
+}
+GTSAM_SIMD_AVX512F_INLINE Double8 sub8(Double8 a, Double8 b) {
+  return _mm512_sub_pd(a, b);
+}
+GTSAM_SIMD_AVX512F_INLINE Double8 mul8(Double8 a, Double8 b) {
+  return _mm512_mul_pd(a, b);
+}
+/// a*b + c in one instruction.
+GTSAM_SIMD_AVX512F_INLINE Double8 fmadd8(Double8 a, Double8 b, Double8 c) {
+  return _mm512_fmadd_pd(a, b, c);
+}
+// _mm512_sqrt_pd expands through _mm512_undefined_pd(), whose deliberately
+// uninitialized register trips GCC's -Wmaybe-uninitialized once inlined into
+// a kernel; silence that known false positive here only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+GTSAM_SIMD_AVX512F_INLINE Double8 sqrt8(Double8 a) { return _mm512_sqrt_pd(a); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+GTSAM_SIMD_AVX512F_INLINE void store8(double* p, Double8 a) {
+  _mm512_storeu_pd(p, a);
+}
+
+/// @}
+
+#endif  // GTSAM_SIMD_X86
+
+#ifdef GTSAM_SIMD_NEON
+
+/// @name 2-wide double lane (NEON), AArch64 only
+/// @{
+
+/// Two doubles in one NEON register.
+using Double2 = float64x2_t;
+
+inline Double2 load2(const double* p) { return vld1q_f64(p); }
+inline Double2 set2(double x) { return vdupq_n_f64(x); }
+inline Double2 add2(Double2 a, Double2 b) { return vaddq_f64(a, b); }
+inline Double2 sub2(Double2 a, Double2 b) { return vsubq_f64(a, b); }
+inline Double2 mul2(Double2 a, Double2 b) { return vmulq_f64(a, b); }
+/// a*b + c in one instruction.
+inline Double2 fmadd2(Double2 a, Double2 b, Double2 c) {
+  return vfmaq_f64(c, a, b);
+}
+inline Double2 sqrt2(Double2 a) { return vsqrtq_f64(a); }
+inline void store2(double* p, Double2 a) { vst1q_f64(p, a); }
+
+/// @}
+
+#endif  // GTSAM_SIMD_NEON
+
+}  // namespace simd
+}  // namespace gtsam
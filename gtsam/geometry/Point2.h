@@ -23,12 +23,19 @@
 #include <boost/serialization/nvp.hpp>
 #endif
 
+#include <array>
+#include <cmath>
 #include <optional>
 
 namespace gtsam {
 
 /// As of GTSAM 4, in order to make GTSAM more lean,
-/// it is now possible to just typedef Point2 to Vector2
+/// it is now possible to just typedef Point2 to Vector2.
+/// This also means Point2 *is* an Eigen::Vector2d: conversions to and from
+/// Eigen expressions are zero-copy aliasing, the 16-byte-aligned storage fits
+/// in one XMM register, and arithmetic uses Eigen's vectorized kernels
+/// directly, with none of the per-conversion load/store overhead the old
+/// x_,y_ scalar-member class had.
 typedef Vector2 Point2;
   
 // Convenience typedef
@@ -37,15 +44,59 @@ GTSAM_EXPORT std::ostream &operator<<(std::ostream &os, const gtsam::Point2Pair
 
 using Point2Pairs = std::vector<Point2Pair>;
 
-/// Distance of the point from the origin, with Jacobian
-GTSAM_EXPORT double norm2(const Point2& p, OptionalJacobian<1, 2> H = {});
+/// Distance of the point from the origin, with Jacobian.
+/// Header-inline: the body is two multiplies and a sqrt, and keeping it out
+/// of line would hide it behind an exported symbol and block inlining into
+/// the factor evaluation loops that call it millions of times.
+inline double norm2(const Point2& p, OptionalJacobian<1, 2> H = {}) {
+  double r = std::sqrt(p.x() * p.x() + p.y() * p.y());
+  if (H) {
+    if (std::abs(r) > 1e-10)
+      *H << p.x() / r, p.y() / r;
+    else
+      *H << 1, 1;  // really infinity, why 1 ?
+  }
+  return r;
+}
+
+/// distance between two points, inline for the same reason as norm2
+inline double distance2(const Point2& p, const Point2& q,
+                        OptionalJacobian<1, 2> H1 = {},
+                        OptionalJacobian<1, 2> H2 = {}) {
+  Point2 d = q - p;
+  if (H1 || H2) {
+    Matrix12 H;
+    double r = norm2(d, H);
+    if (H1) *H1 = -H;
+    if (H2) *H2 =  H;
+    return r;
+  } else {
+    return d.norm();
+  }
+}
 
-/// distance between two points
-GTSAM_EXPORT double distance2(const Point2& p1, const Point2& q,
-                 OptionalJacobian<1, 2> H1 = {},
-                 OptionalJacobian<1, 2> H2 = {});
+/**
+ * Normalize to unit length, with optional Jacobian.
+ * Computes p * (1/sqrt(x^2+y^2)): one sqrt, one divide and two multiplies,
+ * instead of the sqrt followed by two divides of p / norm2(p). Inline so
+ * that when no Jacobian is requested the branch folds away at the call site.
+ */
+inline Point2 normalize2(const Point2& p, OptionalJacobian<2, 2> H = {}) {
+  const double n2 = p.x() * p.x() + p.y() * p.y();
+  const double invNorm = 1.0 / std::sqrt(n2);
+  const Point2 normalized(p.x() * invNorm, p.y() * invNorm);
+  if (H) {
+    // d(p/|p|)/dp = (I - p p^T / |p|^2) / |p|
+    *H << p.y() * p.y(), -p.x() * p.y(), -p.x() * p.y(), p.x() * p.x();
+    *H *= invNorm * invNorm * invNorm;
+  }
+  return normalized;
+}
 
-// For MATLAB wrapper
+// Also used by the MATLAB wrapper. Prefer this over a plain
+// std::vector<Point2> for bulk Point2 data: the Eigen aligned allocator
+// guarantees 16-byte alignment of every element, so each Point2 is one
+// aligned 128-bit load instead of a potentially split access.
 typedef std::vector<Point2, Eigen::aligned_allocator<Point2> > Point2Vector;
 
 /// multiply with scalar
@@ -53,6 +104,14 @@ inline Point2 operator*(double s, const Point2& p) {
   return Point2(s * p.x(), s * p.y());
 }
 
+/// Affine update p + a*d in one expression. Eigen contracts this to a single
+/// fused multiply-add per component when FMA is available, halving the
+/// dependency chain of the two-step multiply-then-add in compose/retract
+/// style iterative updates.
+inline Point2 axpy2(double a, const Point2& d, const Point2& p) {
+  return p + a * d;
+}
+
 /*
  * @brief Circle-circle intersection, given normalized radii.
  * Calculate f and h, respectively the parallel and perpendicular distance of
@@ -69,6 +128,30 @@ inline Point2 operator*(double s, const Point2& p) {
  */
 GTSAM_EXPORT std::optional<Point2> circleCircleIntersection(double R_d, double r_d, double tol = 1e-9);
 
+/*
+ * @brief Circle-circle intersection, given normalized radii, out-parameter form.
+ * Identical math to the optional-returning overload above, but returns a bool
+ * and writes (f,h) into fh only when a solution exists. The body is inline so
+ * hot callers can keep f and h in registers without materializing an optional.
+ * @param R_d : R/d, ratio of radius of first circle to distance between centers
+ * @param r_d : r/d, ratio of radius of second circle to distance between centers
+ * @param fh : output, the (f,h) solution pair, untouched if there is none
+ * @param tol: absolute tolerance below which we consider touching circles
+ * @return true if the circles intersect
+ */
+inline bool circleCircleIntersection(double R_d, double r_d, Point2& fh,
+                                     double tol = 1e-9) {
+  double R2_d2 = R_d*R_d; // Yes, RD-D2 !
+  double f = 0.5 + 0.5*(R2_d2 - r_d*r_d);
+  double h2 = R2_d2 - f*f; // just right triangle rule
+
+  // h^2<0 is equivalent to (d > (R + r) || d < (R - r))
+  // Hence, there are only solutions if >=0
+  if (h2<-tol) return false; // allow *slightly* negative
+  fh = Point2(f, h2<tol ? 0.0 : std::sqrt(h2));
+  return true;
+}
+
 /*
  * @brief Circle-circle intersection, from the normalized radii solution.
  * @param c1 center of first circle
@@ -76,7 +159,22 @@ GTSAM_EXPORT std::optional<Point2> circleCircleIntersection(double R_d, double r
  * @return list of solutions (0,1, or 2). Identical circles will return empty list, as well.
  */
 GTSAM_EXPORT std::list<Point2> circleCircleIntersection(Point2 c1, Point2 c2, std::optional<Point2> fh);
-  
+
+/*
+ * @brief Circle-circle intersection, from the normalized radii solution,
+ * writing into a caller-provided fixed-size array.
+ * Allocation-free alternative to the std::list overload above: the 0, 1, or 2
+ * solutions are written into the first entries of the array, which lives on
+ * the caller's stack, instead of heap-allocating a list node per solution.
+ * @param c1 center of first circle
+ * @param c2 center of second circle
+ * @param fh normalized solution pair, as returned by the overload above
+ * @param solutions output array, only the first (returned count) entries are valid
+ * @return number of solutions (0, 1, or 2). Identical circles yield 0.
+ */
+GTSAM_EXPORT size_t circleCircleIntersection(Point2 c1, Point2 c2,
+    const std::optional<Point2>& fh, std::array<Point2, 2>& solutions);
+
 /// Calculate the two means of a set of Point2 pairs
 GTSAM_EXPORT Point2Pair means(const std::vector<Point2Pair> &abPointPairs);
 
@@ -92,6 +190,20 @@ GTSAM_EXPORT Point2Pair means(const std::vector<Point2Pair> &abPointPairs);
 GTSAM_EXPORT std::list<Point2> circleCircleIntersection(Point2 c1, double r1,
     Point2 c2, double r2, double tol = 1e-9);
 
+/**
+ * @brief Intersect 2 circles, writing into a caller-provided fixed-size array.
+ * Allocation-free alternative to the std::list overload above.
+ * @param c1 center of first circle
+ * @param r1 radius of first circle
+ * @param c2 center of second circle
+ * @param r2 radius of second circle
+ * @param solutions output array, only the first (returned count) entries are valid
+ * @param tol: absolute tolerance below which we consider touching circles
+ * @return number of solutions (0, 1, or 2). Identical circles yield 0.
+ */
+GTSAM_EXPORT size_t circleCircleIntersection(Point2 c1, double r1, Point2 c2,
+    double r2, std::array<Point2, 2>& solutions, double tol = 1e-9);
+
 template <typename A1, typename A2>
 struct Range;
 
@@ -0,0 +1,240 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    Point2SoA.cpp
+ * @brief   Structure-of-arrays storage for batches of 2D points
+ * @author  Frank Dellaert
+ */
+
+#include <gtsam/base/simd.h>
+#include <gtsam/geometry/Point2SoA.h>
+
+#include <cassert>
+#include <cmath>
+
+namespace gtsam {
+
+namespace {
+
+#ifdef GTSAM_SIMD_X86
+
+// out[i] = sqrt(xs[i]^2 + ys[i]^2), four points per iteration.
+GTSAM_SIMD_TARGET_AVX2 void norm2Avx2(const double* xs, const double* ys,
+                                      double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const simd::Double4 x = simd::load4(xs + i);
+    const simd::Double4 y = simd::load4(ys + i);
+    const simd::Double4 s = simd::fmadd4(y, y, simd::mul4(x, x));
+    simd::store4(out + i, simd::sqrt4(s));
+  }
+  // Scalar tail for the last n % 4 points.
+  for (; i < n; i++) out[i] = std::sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+}
+
+// out[i] = sqrt((qxs[i]-pxs[i])^2 + (qys[i]-pys[i])^2), four pairs per
+// iteration.
+GTSAM_SIMD_TARGET_AVX2 void distance2Avx2(const double* pxs, const double* pys,
+                                          const double* qxs, const double* qys,
+                                          double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const simd::Double4 dx = simd::sub4(simd::load4(qxs + i), simd::load4(pxs + i));
+    const simd::Double4 dy = simd::sub4(simd::load4(qys + i), simd::load4(pys + i));
+    const simd::Double4 s = simd::fmadd4(dy, dy, simd::mul4(dx, dx));
+    simd::store4(out + i, simd::sqrt4(s));
+  }
+  for (; i < n; i++) {
+    const double dx = qxs[i] - pxs[i];
+    const double dy = qys[i] - pys[i];
+    out[i] = std::sqrt(dx * dx + dy * dy);
+  }
+}
+
+// xs[i] += a*dxs[i], ys[i] += a*dys[i], four points per iteration.
+GTSAM_SIMD_TARGET_AVX2 void axpy2Avx2(double a, const double* dxs,
+                                      const double* dys, double* xs,
+                                      double* ys, size_t n) {
+  const simd::Double4 a4 = simd::set4(a);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    simd::store4(xs + i, simd::fmadd4(a4, simd::load4(dxs + i), simd::load4(xs + i)));
+    simd::store4(ys + i, simd::fmadd4(a4, simd::load4(dys + i), simd::load4(ys + i)));
+  }
+  for (; i < n; i++) {
+    xs[i] += a * dxs[i];
+    ys[i] += a * dys[i];
+  }
+}
+
+// Same as distance2Avx2, but eight pairs per iteration in zmm registers:
+// twice the FMA throughput per cycle and half the loop overhead on CPUs
+// with AVX-512F. Tails shorter than eight pairs fall back to the AVX2
+// kernel, which handles its own scalar remainder.
+GTSAM_SIMD_TARGET_AVX512F void distance2Avx512(const double* pxs,
+                                               const double* pys,
+                                               const double* qxs,
+                                               const double* qys, double* out,
+                                               size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const simd::Double8 dx = simd::sub8(simd::load8(qxs + i), simd::load8(pxs + i));
+    const simd::Double8 dy = simd::sub8(simd::load8(qys + i), simd::load8(pys + i));
+    const simd::Double8 s = simd::fmadd8(dy, dy, simd::mul8(dx, dx));
+    simd::store8(out + i, simd::sqrt8(s));
+  }
+  if (i < n) distance2Avx2(pxs + i, pys + i, qxs + i, qys + i, out + i, n - i);
+}
+
+#endif  // GTSAM_SIMD_X86
+
+#ifdef GTSAM_SIMD_NEON
+
+// NEON is baseline on AArch64, so these two-wide variants need no runtime
+// dispatch.
+void norm2Neon(const double* xs, const double* ys, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const simd::Double2 x = simd::load2(xs + i);
+    const simd::Double2 y = simd::load2(ys + i);
+    const simd::Double2 s = simd::fmadd2(y, y, simd::mul2(x, x));
+    simd::store2(out + i, simd::sqrt2(s));
+  }
+  if (i < n) out[i] = std::sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+}
+
+void distance2Neon(const double* pxs, const double* pys, const double* qxs,
+                   const double* qys, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const simd::Double2 dx = simd::sub2(simd::load2(qxs + i), simd::load2(pxs + i));
+    const simd::Double2 dy = simd::sub2(simd::load2(qys + i), simd::load2(pys + i));
+    const simd::Double2 s = simd::fmadd2(dy, dy, simd::mul2(dx, dx));
+    simd::store2(out + i, simd::sqrt2(s));
+  }
+  if (i < n) {
+    const double dx = qxs[i] - pxs[i];
+    const double dy = qys[i] - pys[i];
+    out[i] = std::sqrt(dx * dx + dy * dy);
+  }
+}
+
+void axpy2Neon(double a, const double* dxs, const double* dys, double* xs,
+               double* ys, size_t n) {
+  const simd::Double2 a2 = simd::set2(a);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    simd::store2(xs + i, simd::fmadd2(a2, simd::load2(dxs + i), simd::load2(xs + i)));
+    simd::store2(ys + i, simd::fmadd2(a2, simd::load2(dys + i), simd::load2(ys + i)));
+  }
+  if (i < n) {
+    xs[i] += a * dxs[i];
+    ys[i] += a * dys[i];
+  }
+}
+
+#endif  // GTSAM_SIMD_NEON
+
+}  // namespace
+
+/* ************************************************************************* */
+Point2SoA::Point2SoA(const Point2Vector& points) {
+  const size_t n = points.size();
+  xs.resize(n);
+  ys.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    xs[i] = points[i].x();
+    ys[i] = points[i].y();
+  }
+}
+
+/* ************************************************************************* */
+Point2Vector Point2SoA::toVector() const {
+  const size_t n = size();
+  Point2Vector points;
+  points.reserve(n);
+  for (size_t i = 0; i < n; i++) points.emplace_back(xs[i], ys[i]);
+  return points;
+}
+
+/* ************************************************************************* */
+void norm2(const Point2SoA& points, double* out) {
+  const size_t n = points.size();
+  const double* xs = points.xs.data();
+  const double* ys = points.ys.data();
+#ifdef GTSAM_SIMD_X86
+  if (simd::hasAVX2()) {
+    norm2Avx2(xs, ys, out, n);
+    return;
+  }
+#elif defined(GTSAM_SIMD_NEON)
+  norm2Neon(xs, ys, out, n);
+  return;
+#endif
+  // Unit-stride loads from xs/ys let the compiler vectorize this loop.
+  for (size_t i = 0; i < n; i++) {
+    out[i] = std::sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+  }
+}
+
+/* ************************************************************************* */
+void axpy2(double a, const Point2SoA& ds, Point2SoA& ps) {
+  assert(ds.size() == ps.size());
+  const size_t n = ps.size();
+  const double* dxs = ds.xs.data();
+  const double* dys = ds.ys.data();
+  double* xs = ps.xs.data();
+  double* ys = ps.ys.data();
+#ifdef GTSAM_SIMD_X86
+  if (simd::hasAVX2()) {
+    axpy2Avx2(a, dxs, dys, xs, ys, n);
+    return;
+  }
+#elif defined(GTSAM_SIMD_NEON)
+  axpy2Neon(a, dxs, dys, xs, ys, n);
+  return;
+#endif
+  for (size_t i = 0; i < n; i++) {
+    xs[i] += a * dxs[i];
+    ys[i] += a * dys[i];
+  }
+}
+
+/* ************************************************************************* */
+void distance2(const Point2SoA& ps, const Point2SoA& qs, double* out) {
+  assert(ps.size() == qs.size());
+  const size_t n = ps.size();
+  const double* pxs = ps.xs.data();
+  const double* pys = ps.ys.data();
+  const double* qxs = qs.xs.data();
+  const double* qys = qs.ys.data();
+#ifdef GTSAM_SIMD_X86
+  if (simd::hasAVX512F()) {
+    distance2Avx512(pxs, pys, qxs, qys, out, n);
+    return;
+  }
+  if (simd::hasAVX2()) {
+    distance2Avx2(pxs, pys, qxs, qys, out, n);
+    return;
+  }
+#elif defined(GTSAM_SIMD_NEON)
+  distance2Neon(pxs, pys, qxs, qys, out, n);
+  return;
+#endif
+  for (size_t i = 0; i < n; i++) {
+    const double dx = qxs[i] - pxs[i];
+    const double dy = qys[i] - pys[i];
+    out[i] = std::sqrt(dx * dx + dy * dy);
+  }
+}
+
+}  // namespace gtsam
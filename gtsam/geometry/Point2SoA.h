@@ -0,0 +1,95 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    Point2SoA.h
+ * @brief   Structure-of-arrays storage for batches of 2D points
+ * @author  Frank Dellaert
+ */
+
+#pragma once
+
+#include <gtsam/geometry/Point2.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Structure-of-arrays (SoA) storage for a batch of Point2.
+ *
+ * A std::vector<Point2> interleaves x and y in memory, so batch operations
+ * such as computing the norm or pairwise distance of many points read the
+ * coordinates with stride 2 and cannot be vectorized effectively. Point2SoA
+ * keeps the x and y coordinates in two separate contiguous arrays, so batch
+ * kernels read unit-stride and the compiler can pack several points per
+ * SIMD register. The scalar Point2 API is unchanged; use this container only
+ * for bulk geometry pipelines where the loop over points is the hot path.
+ */
+struct GTSAM_EXPORT Point2SoA {
+  /// x and y coordinates, stored separately. Eigen's aligned allocator
+  /// guarantees alignment suitable for vector loads.
+  std::vector<double, Eigen::aligned_allocator<double>> xs, ys;
+
+  Point2SoA() {}
+
+  /// Construct from interleaved points, de-interleaving into xs/ys.
+  explicit Point2SoA(const Point2Vector& points);
+
+  /// Number of points.
+  size_t size() const { return xs.size(); }
+
+  /// Pre-allocate storage for n points.
+  void reserve(size_t n) {
+    xs.reserve(n);
+    ys.reserve(n);
+  }
+
+  /// Append a point.
+  void push_back(const Point2& p) {
+    xs.push_back(p.x());
+    ys.push_back(p.y());
+  }
+
+  /// Reassemble point i (for interoperability, not for hot loops).
+  Point2 at(size_t i) const { return Point2(xs[i], ys[i]); }
+
+  /// Convert back to interleaved storage.
+  Point2Vector toVector() const;
+};
+
+/**
+ * Batch version of norm2: out[i] = || points[i] ||.
+ * @param points batch of points in SoA layout
+ * @param out array of at least points.size() doubles
+ */
+GTSAM_EXPORT void norm2(const Point2SoA& points, double* out);
+
+/**
+ * Batch version of axpy2: ps[i] += a * ds[i], fused multiply-add per lane.
+ * Both batches must have the same size.
+ * @param a scalar multiplier
+ * @param ds batch of update directions in SoA layout
+ * @param ps batch of points updated in place
+ */
+GTSAM_EXPORT void axpy2(double a, const Point2SoA& ds, Point2SoA& ps);
+
+/**
+ * Batch version of distance2: out[i] = || qs[i] - ps[i] ||.
+ * Both batches must have the same size.
+ * @param ps first batch of points in SoA layout
+ * @param qs second batch of points in SoA layout
+ * @param out array of at least ps.size() doubles
+ */
+GTSAM_EXPORT void distance2(const Point2SoA& ps, const Point2SoA& qs,
+                            double* out);
+
+}  // namespace gtsam
@@ -72,6 +72,29 @@ TEST(Point2, equality) {
   EXPECT(!(p1 == p2));
 }
 
+/* ************************************************************************* */
+TEST(Point2, LieBranchFree) {
+  Point2 p1(1, 2), p2(4, 5);
+  Matrix H1, H2;
+
+  // Compile-time-selected variants must match the optional-Jacobian ones.
+  EXPECT(assert_equal(Point2(5, 7),
+                      traits<Point2>::ComposeImpl<true>(p1, p2, H1, H2)));
+  EXPECT(assert_equal(I_2x2, H1));
+  EXPECT(assert_equal(I_2x2, H2));
+  EXPECT(assert_equal(Point2(5, 7), traits<Point2>::ComposeImpl<false>(p1, p2)));
+
+  EXPECT(assert_equal(Point2(3, 3),
+                      traits<Point2>::BetweenImpl<true>(p1, p2, H1, H2)));
+  EXPECT(assert_equal(-I_2x2, H1));
+  EXPECT(assert_equal(I_2x2, H2));
+  EXPECT(assert_equal(Point2(3, 3), traits<Point2>::BetweenImpl<false>(p1, p2)));
+
+  EXPECT(assert_equal(Point2(-1, -2), traits<Point2>::InverseImpl<true>(p1, H1)));
+  EXPECT(assert_equal(-I_2x2, H1));
+  EXPECT(assert_equal(Point2(-1, -2), traits<Point2>::InverseImpl<false>(p1)));
+}
+
 /* ************************************************************************* */
 TEST(Point2, Lie) {
   Point2 p1(1, 2), p2(4, 5);
@@ -189,6 +212,34 @@ TEST( Point2, distance ) {
   EXPECT(assert_equal(expectedH2,actualH2));
 }
 
+/* ************************************************************************* */
+namespace {
+Point2 normalize_proxy(const Point2& p) { return normalize2(p); }
+}
+
+TEST( Point2, normalize2) {
+  Point2 p(3, 4);
+  Matrix actualH(2, 2);
+  EXPECT(assert_equal(Point2(0.6, 0.8), normalize2(p, actualH), 1e-9));
+
+  // Check the Jacobian against the numerical derivative
+  Matrix expectedH = numericalDerivative11<Point2, Point2>(normalize_proxy, p);
+  EXPECT(assert_equal(expectedH, actualH, 1e-6));
+}
+
+/* ************************************************************************* */
+TEST( Point2, circleCircleIntersectionOutParam) {
+
+  // The bool/out-parameter overload must agree with the optional-returning one.
+  Point2 fh;
+  EXPECT(!circleCircleIntersection(0.5, 0.2, fh)); // circles do not intersect
+  EXPECT(circleCircleIntersection(1.0, 1.0, fh)); // two solutions
+  std::optional<Point2> expected = circleCircleIntersection(1.0, 1.0);
+  EXPECT(assert_equal(*expected, fh));
+  EXPECT(circleCircleIntersection(0.5, 0.5, fh)); // touching circles
+  EXPECT_DOUBLES_EQUAL(0.0, fh.y(), 1e-9);
+}
+
 /* ************************************************************************* */
 TEST( Point2, circleCircleIntersection) {
 
@@ -237,6 +288,28 @@ TEST( Point2, circleCircleIntersection) {
 
 }
 
+/* ************************************************************************* */
+TEST( Point2, circleCircleIntersectionArray) {
+
+  double offset = 0.994987;
+  std::array<Point2, 2> solutions;
+
+  // no intersection
+  EXPECT_LONGS_EQUAL(
+      0, circleCircleIntersection(Point2(0, 0), 5, Point2(0, 0), 1, solutions));
+
+  // touching circles, one solution
+  EXPECT_LONGS_EQUAL(
+      1, circleCircleIntersection(Point2(0, 0), 5, Point2(4, 0), 1, solutions));
+  EXPECT(assert_equal(Point2(5, 0), solutions[0], 1e-6));
+
+  // two solutions, in the same order the list overload returns them
+  EXPECT_LONGS_EQUAL(
+      2, circleCircleIntersection(Point2(0, 0), 5, Point2(5, 0), 1, solutions));
+  EXPECT(assert_equal(Point2(4.9,  offset), solutions[0], 1e-6));
+  EXPECT(assert_equal(Point2(4.9, -offset), solutions[1], 1e-6));
+}
+
 /* ************************************************************************* */
 int main () {
   TestResult tr;
@@ -0,0 +1,99 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file   testPoint2SoA.cpp
+ * @brief  Unit tests for structure-of-arrays Point2 batches
+ * @author Frank Dellaert
+ **/
+
+#include <gtsam/geometry/Point2SoA.h>
+#include <CppUnitLite/TestHarness.h>
+
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(Point2SoA, Conversion) {
+  Point2Vector points;
+  points.emplace_back(1, 2);
+  points.emplace_back(3, 4);
+  points.emplace_back(-5, 6);
+
+  Point2SoA soa(points);
+  LONGS_EQUAL(3, soa.size());
+  EXPECT(assert_equal(Point2(3, 4), soa.at(1)));
+
+  Point2Vector roundTrip = soa.toVector();
+  LONGS_EQUAL(3, roundTrip.size());
+  for (size_t i = 0; i < points.size(); i++)
+    EXPECT(assert_equal(points[i], roundTrip[i]));
+}
+
+/* ************************************************************************* */
+TEST(Point2SoA, BatchNorm) {
+  Point2SoA soa;
+  soa.push_back(Point2(3, 4));
+  soa.push_back(Point2(0, 0));
+  soa.push_back(Point2(-6, 8));
+
+  vector<double> norms(soa.size());
+  norm2(soa, norms.data());
+  DOUBLES_EQUAL(5.0, norms[0], 1e-9);
+  DOUBLES_EQUAL(0.0, norms[1], 1e-9);
+  DOUBLES_EQUAL(10.0, norms[2], 1e-9);
+
+  // Batch result matches the scalar norm2 for every point, also for sizes
+  // that are not a multiple of the SIMD width.
+  for (size_t i = 0; i < 11; i++) soa.push_back(Point2(0.1 * i, 7.0 - i));
+  norms.resize(soa.size());
+  norm2(soa, norms.data());
+  for (size_t i = 0; i < soa.size(); i++)
+    DOUBLES_EQUAL(norm2(soa.at(i)), norms[i], 1e-9);
+}
+
+/* ************************************************************************* */
+TEST(Point2SoA, BatchDistance) {
+  Point2SoA ps, qs;
+  for (size_t i = 0; i < 10; i++) {
+    ps.push_back(Point2(1.0 * i, 2.0 * i));
+    qs.push_back(Point2(3.0 - i, 0.5 * i));
+  }
+
+  vector<double> distances(ps.size());
+  distance2(ps, qs, distances.data());
+  for (size_t i = 0; i < ps.size(); i++)
+    DOUBLES_EQUAL(distance2(ps.at(i), qs.at(i)), distances[i], 1e-9);
+}
+
+/* ************************************************************************* */
+TEST(Point2SoA, BatchAxpy) {
+  Point2SoA ps, ds;
+  for (size_t i = 0; i < 9; i++) {
+    ps.push_back(Point2(1.0 * i, -2.0 * i));
+    ds.push_back(Point2(0.5 * i, 1.0 + i));
+  }
+  const double a = 0.25;
+
+  Point2SoA expected = ps;
+  axpy2(a, ds, ps);
+  for (size_t i = 0; i < ps.size(); i++)
+    EXPECT(assert_equal(axpy2(a, ds.at(i), expected.at(i)), ps.at(i)));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -5,135 +5,316 @@
  *  @date July 2020
  */
 
+#include <gtsam/base/simd.h>
 #include <gtsam/sfm/MFAS.h>
 
 #include <algorithm>
+#include <cmath>
 #include <map>
+#include <numeric>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
-#include <unordered_set>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 
 using namespace gtsam;
 using std::map;
 using std::pair;
 using std::unordered_map;
 using std::vector;
-using std::unordered_set;
-
-// A node in the graph.
-struct GraphNode {
-  double inWeightSum;               // Sum of absolute weights of incoming edges
-  double outWeightSum;              // Sum of absolute weights of outgoing edges
-  unordered_set<Key> inNeighbors;   // Nodes from which there is an incoming edge
-  unordered_set<Key> outNeighbors;  // Nodes to which there is an outgoing edge
-
-  // Heuristic for the node that is to select nodes in MFAS.
-  double heuristic() const { return (outWeightSum + 1) / (inWeightSum + 1); }
-};
-
-// A graph is a map from key to GraphNode. This function returns the graph from
-// the edgeWeights between keys.
-unordered_map<Key, GraphNode> graphFromEdges(
-    const map<MFAS::KeyPair, double>& edgeWeights) {
-  unordered_map<Key, GraphNode> graph;
-
-  for (const auto& edgeWeight : edgeWeights) {
-    // The weights can be either negative or positive. The direction of the edge
-    // is the direction of positive weight. This means that the edges is from
-    // edge.first -> edge.second if weight is positive and edge.second ->
-    // edge.first if weight is negative.
-    const MFAS::KeyPair& edge = edgeWeight.first;
-    const double& weight = edgeWeight.second;
-
-    Key edgeSource = weight >= 0 ? edge.first : edge.second;
-    Key edgeDest = weight >= 0 ? edge.second : edge.first;
-
-    // Update the in weight and neighbors for the destination.
-    graph[edgeDest].inWeightSum += std::abs(weight);
-    graph[edgeDest].inNeighbors.insert(edgeSource);
-
-    // Update the out weight and neighbors for the source.
-    graph[edgeSource].outWeightSum += std::abs(weight);
-    graph[edgeSource].outNeighbors.insert(edgeDest);
-  }
-  return graph;
-}
 
-// Selects the next node in the ordering from the graph.
-Key selectNextNodeInOrdering(const unordered_map<Key, GraphNode>& graph) {
-  // Find the root nodes in the graph.
-  for (const auto& keyNode : graph) {
-    // It is a root node if the inWeightSum is close to zero.
-    if (keyNode.second.inWeightSum < 1e-8) {
-      // TODO(akshay-krishnan) if there are multiple roots, it is better to
-      // choose the one with highest heuristic. This is missing in the 1dsfm
-      // solution.
-      return keyNode.first;
-    }
+namespace {
+
+// w[i] = tx[i]*px + ty[i]*py + tz[i]*pz: projection of every edge's unit
+// translation onto the projection direction, four edges per iteration.
+#ifdef GTSAM_SIMD_X86
+GTSAM_SIMD_TARGET_AVX2 void projectEdgesAvx2(const double* tx, const double* ty,
+                                             const double* tz, double px,
+                                             double py, double pz, double* w,
+                                             size_t n) {
+  const simd::Double4 px4 = simd::set4(px);
+  const simd::Double4 py4 = simd::set4(py);
+  const simd::Double4 pz4 = simd::set4(pz);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const simd::Double4 dots = simd::fmadd4(
+        simd::load4(tx + i), px4,
+        simd::fmadd4(simd::load4(ty + i), py4,
+                     simd::mul4(simd::load4(tz + i), pz4)));
+    simd::store4(w + i, dots);
   }
-  // If there are no root nodes, return the node with the highest heuristic.
-  return std::max_element(graph.begin(), graph.end(),
-                          [](const std::pair<Key, GraphNode>& keyNode1,
-                             const std::pair<Key, GraphNode>& keyNode2) {
-                            return keyNode1.second.heuristic() <
-                                   keyNode2.second.heuristic();
-                          })
-      ->first;
+  for (; i < n; i++) w[i] = tx[i] * px + ty[i] * py + tz[i] * pz;
 }
+#endif
 
-// Returns the absolute weight of the edge between node1 and node2.
-double absWeightOfEdge(const Key key1, const Key key2,
-                       const map<MFAS::KeyPair, double>& edgeWeights) {
-  // Check the direction of the edge before returning.
-  return edgeWeights.find(MFAS::KeyPair(key1, key2)) != edgeWeights.end()
-             ? std::abs(edgeWeights.at(MFAS::KeyPair(key1, key2)))
-             : std::abs(edgeWeights.at(MFAS::KeyPair(key2, key1)));
+// Scalar fallback; with the SoA inputs this is a unit-stride loop the
+// compiler can vectorize on its own.
+void projectEdges(const double* tx, const double* ty, const double* tz,
+                  double px, double py, double pz, double* w, size_t n) {
+#ifdef GTSAM_SIMD_X86
+  if (simd::hasAVX2()) {
+    projectEdgesAvx2(tx, ty, tz, px, py, pz, w, n);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < n; i++) w[i] = tx[i] * px + ty[i] * py + tz[i] * pz;
 }
 
-// Removes a node from the graph and updates edge weights of its neighbors.
-void removeNodeFromGraph(const Key node,
-                         const map<MFAS::KeyPair, double> edgeWeights,
-                         unordered_map<Key, GraphNode>& graph) {
-  // Update the outweights and outNeighbors of node's inNeighbors
-  for (const Key neighbor : graph[node].inNeighbors) {
-    // the edge could be either (*it, choice) with a positive weight or
-    // (choice, *it) with a negative weight
-    graph[neighbor].outWeightSum -=
-        absWeightOfEdge(node, neighbor, edgeWeights);
-    graph[neighbor].outNeighbors.erase(node);
-  }
-  // Update the inWeights and inNeighbors of node's outNeighbors
-  for (const Key neighbor : graph[node].outNeighbors) {
-    graph[neighbor].inWeightSum -= absWeightOfEdge(node, neighbor, edgeWeights);
-    graph[neighbor].inNeighbors.erase(node);
-  }
-  // Erase node.
-  graph.erase(node);
+// Reverse Cuthill-McKee order of the CSR graph: breadth-first search from a
+// minimum-degree node of every component, visiting neighbors by increasing
+// degree, with the final order reversed. Graph neighbors end up with nearby
+// positions, which keeps the per-node accumulator updates in
+// MFAS::computeOrdering within a small window of the arrays.
+vector<std::uint32_t> reverseCuthillMcKee(const vector<size_t>& rowPtr,
+                                          const vector<std::uint32_t>& nbrIdx) {
+  const size_t numNodes = rowPtr.size() - 1;
+  auto degree = [&rowPtr](std::uint32_t node) {
+    return rowPtr[node + 1] - rowPtr[node];
+  };
+
+  vector<std::uint32_t> order;
+  order.reserve(numNodes);
+  vector<bool> visited(numNodes, false);
+
+  // Seed nodes in increasing degree order, so every component starts from a
+  // minimum-degree node.
+  vector<std::uint32_t> seeds(numNodes);
+  std::iota(seeds.begin(), seeds.end(), 0);
+  std::stable_sort(seeds.begin(), seeds.end(),
+                   [&degree](std::uint32_t a, std::uint32_t b) {
+                     return degree(a) < degree(b);
+                   });
+
+  vector<std::uint32_t> neighbors;
+  for (const std::uint32_t seed : seeds) {
+    if (visited[seed]) continue;
+    // Breadth-first search over the seed's component; `order` itself is the
+    // queue, scanned by `front`.
+    const size_t front0 = order.size();
+    visited[seed] = true;
+    order.push_back(seed);
+    for (size_t front = front0; front < order.size(); front++) {
+      const std::uint32_t node = order[front];
+      neighbors.clear();
+      for (size_t j = rowPtr[node]; j < rowPtr[node + 1]; j++) {
+        const std::uint32_t neighbor = nbrIdx[j];
+        if (!visited[neighbor]) {
+          visited[neighbor] = true;
+          neighbors.push_back(neighbor);
+        }
+      }
+      std::stable_sort(neighbors.begin(), neighbors.end(),
+                       [&degree](std::uint32_t a, std::uint32_t b) {
+                         return degree(a) < degree(b);
+                       });
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
 }
+}  // namespace
 
 MFAS::MFAS(const TranslationEdges& relativeTranslations,
            const Unit3& projectionDirection) {
-  // Iterate over edges, obtain weights by projecting
-  // their relativeTranslations along the projection direction
-  for (const auto& measurement : relativeTranslations) {
-    edgeWeights_[{measurement.key1(), measurement.key2()}] =
-        measurement.measured().dot(projectionDirection);
+  // Obtain weights by projecting the relativeTranslations along the
+  // projection direction. Gather the unit translations into SoA arrays and
+  // read the projection direction's unit vector once, so the per-edge work
+  // is a 3-term FMA dot product over contiguous arrays instead of a
+  // Unit3::dot call per edge.
+  const size_t numEdges = relativeTranslations.size();
+  vector<double> tx(numEdges), ty(numEdges), tz(numEdges);
+  vector<PackedKey> keys(numEdges);
+  for (size_t i = 0; i < numEdges; i++) {
+    const auto& measurement = relativeTranslations[i];
+    keys[i] = packKey(measurement.key1(), measurement.key2());
+    const Vector3 t = measurement.measured().unitVector();
+    tx[i] = t.x();
+    ty[i] = t.y();
+    tz[i] = t.z();
+  }
+  const Vector3 p = projectionDirection.unitVector();
+  vector<double> weights(numEdges);
+  projectEdges(tx.data(), ty.data(), tz.data(), p.x(), p.y(), p.z(),
+               weights.data(), numEdges);
+
+  vector<pair<PackedKey, double>> edges;
+  edges.reserve(numEdges);
+  for (size_t i = 0; i < numEdges; i++) {
+    edges.emplace_back(keys[i], weights[i]);
   }
+  setEdges(std::move(edges));
+}
+
+void MFAS::setEdges(vector<pair<PackedKey, double>> edges) {
+  // Canonicalize the edge directions: an edge with negative weight is the
+  // same edge traversed backwards, so flip its key pair and keep the weight
+  // magnitude. After this the hot scans never branch on the sign; the flip
+  // flag is the only per-edge metadata left and lives in its own cold array,
+  // read once per edge when the output map is built.
+  vector<std::tuple<PackedKey, double, std::uint8_t>> canonical;
+  canonical.reserve(edges.size());
+  for (const auto& [packed, weight] : edges) {
+    if (weight < 0) {
+      const KeyPair edge = unpackKey(packed);
+      canonical.emplace_back(packKey(edge.second, edge.first), -weight, 1);
+    } else {
+      canonical.emplace_back(packed, weight, 0);
+    }
+  }
+  // Sort by packed key so that lookups can use binary search, then split
+  // into the parallel hot key/weight arrays and the cold flip flags.
+  std::sort(canonical.begin(), canonical.end());
+  edgeKeys_.clear();
+  edgeWeights_.clear();
+  flipped_.clear();
+  edgeKeys_.reserve(canonical.size());
+  edgeWeights_.reserve(canonical.size());
+  flipped_.reserve(canonical.size());
+  for (const auto& [key, weight, wasFlipped] : canonical) {
+    edgeKeys_.push_back(key);
+    edgeWeights_.push_back(weight);
+    flipped_.push_back(wasFlipped);
+  }
+  buildGraph();
+}
+
+void MFAS::buildGraph() {
+  const size_t numEdges = edgeKeys_.size();
+
+  // Collect the sorted unique node keys; the position of a key in nodes_ is
+  // its dense node id.
+  nodes_.clear();
+  nodes_.reserve(2 * numEdges);
+  for (const PackedKey packed : edgeKeys_) {
+    const KeyPair edge = unpackKey(packed);
+    nodes_.push_back(edge.first);
+    nodes_.push_back(edge.second);
+  }
+  std::sort(nodes_.begin(), nodes_.end());
+  nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+
+  // Classic two-pass CSR build: count the degree of every node, prefix-sum
+  // into row pointers, then fill the rows. Every edge appears in the rows of
+  // both endpoints, with the weight magnitude signed by direction: positive
+  // if the edge leaves the row's node, negative if it enters it.
+  rowPtr_.assign(nodes_.size() + 1, 0);
+  for (const PackedKey packed : edgeKeys_) {
+    const KeyPair edge = unpackKey(packed);
+    rowPtr_[nodeIndex(edge.first) + 1]++;
+    rowPtr_[nodeIndex(edge.second) + 1]++;
+  }
+  std::partial_sum(rowPtr_.begin(), rowPtr_.end(), rowPtr_.begin());
+
+  nbrIdx_.resize(2 * numEdges);
+  nbrWeight_.resize(2 * numEdges);
+  vector<size_t> fill(rowPtr_.begin(), rowPtr_.end() - 1);
+  for (size_t i = 0; i < numEdges; i++) {
+    // The edge arrays are canonicalized by setEdges, so every edge is from
+    // edge.first to edge.second and its weight is positive.
+    const KeyPair edge = unpackKey(edgeKeys_[i]);
+    const double weight = edgeWeights_[i];
+    const size_t source = nodeIndex(edge.first);
+    const size_t dest = nodeIndex(edge.second);
+
+    nbrIdx_[fill[source]] = static_cast<std::uint32_t>(dest);
+    nbrWeight_[fill[source]++] = weight;
+    nbrIdx_[fill[dest]] = static_cast<std::uint32_t>(source);
+    nbrWeight_[fill[dest]++] = -weight;
+  }
+
+  // Relabel the CSR into reverse Cuthill-McKee order so graph neighbors are
+  // also memory neighbors; see the member comment in MFAS.h.
+  csrToNode_ = reverseCuthillMcKee(rowPtr_, nbrIdx_);
+  csrIndex_.resize(nodes_.size());
+  for (size_t csr = 0; csr < csrToNode_.size(); csr++) {
+    csrIndex_[csrToNode_[csr]] = static_cast<std::uint32_t>(csr);
+  }
+  vector<size_t> newRowPtr(rowPtr_.size());
+  vector<std::uint32_t> newNbrIdx(nbrIdx_.size());
+  vector<double> newNbrWeight(nbrWeight_.size());
+  newRowPtr[0] = 0;
+  for (size_t csr = 0; csr < csrToNode_.size(); csr++) {
+    const std::uint32_t node = csrToNode_[csr];
+    size_t out = newRowPtr[csr];
+    for (size_t j = rowPtr_[node]; j < rowPtr_[node + 1]; j++, out++) {
+      newNbrIdx[out] = csrIndex_[nbrIdx_[j]];
+      newNbrWeight[out] = nbrWeight_[j];
+    }
+    newRowPtr[csr + 1] = out;
+  }
+  rowPtr_ = std::move(newRowPtr);
+  nbrIdx_ = std::move(newNbrIdx);
+  nbrWeight_ = std::move(newNbrWeight);
 }
 
 KeyVector MFAS::computeOrdering() const {
+  const size_t numNodes = nodes_.size();
   KeyVector ordering;  // Nodes in MFAS order (result).
+  ordering.reserve(numNodes);
 
-  // A graph is an unordered map from keys to nodes. Each node contains a list
-  // of its adjacent nodes. Create the graph from the edgeWeights.
-  unordered_map<Key, GraphNode> graph = graphFromEdges(edgeWeights_);
+  // Per-node sums of absolute weights of incoming and outgoing edges,
+  // accumulated once from the CSR rows. When a node is removed below, only
+  // its own CSR row is visited to update the sums of its neighbors, instead
+  // of re-scanning the whole edge list per removal.
+  vector<double> inWeightSum(numNodes, 0), outWeightSum(numNodes, 0);
+  for (size_t node = 0; node < numNodes; node++) {
+    for (size_t j = rowPtr_[node]; j < rowPtr_[node + 1]; j++) {
+      const double weight = nbrWeight_[j];
+      if (weight > 0)
+        outWeightSum[node] += weight;
+      else
+        inWeightSum[node] -= weight;
+    }
+  }
 
-  // In each iteration, one node is removed from the graph and appended to the
-  // ordering.
-  while (!graph.empty()) {
-    Key selection = selectNextNodeInOrdering(graph);
-    removeNodeFromGraph(selection, edgeWeights_, graph);
-    ordering.push_back(selection);
+  vector<bool> removed(numNodes, false);
+  for (size_t step = 0; step < numNodes; step++) {
+    // Select the next node: a root node (no incoming weight) if one exists,
+    // otherwise the node with the highest (outWeightSum+1)/(inWeightSum+1)
+    // heuristic. Both scans are unit-stride over the dense sum arrays.
+    size_t selection = numNodes;
+    for (size_t node = 0; node < numNodes; node++) {
+      // It is a root node if the inWeightSum is close to zero.
+      if (!removed[node] && inWeightSum[node] < 1e-8) {
+        // TODO(akshay-krishnan) if there are multiple roots, it is better to
+        // choose the one with highest heuristic. This is missing in the 1dsfm
+        // solution.
+        selection = node;
+        break;
+      }
+    }
+    if (selection == numNodes) {
+      // If there are no root nodes, use the node with the highest heuristic.
+      double bestHeuristic = -1;
+      for (size_t node = 0; node < numNodes; node++) {
+        if (removed[node]) continue;
+        const double heuristic =
+            (outWeightSum[node] + 1) / (inWeightSum[node] + 1);
+        if (heuristic > bestHeuristic) {
+          bestHeuristic = heuristic;
+          selection = node;
+        }
+      }
+    }
+
+    // Remove the selected node: walk its CSR row once, updating the sums of
+    // its still-present neighbors. Translate the CSR id back to a key on emit.
+    ordering.push_back(nodes_[csrToNode_[selection]]);
+    removed[selection] = true;
+    for (size_t j = rowPtr_[selection]; j < rowPtr_[selection + 1]; j++) {
+      const size_t neighbor = nbrIdx_[j];
+      if (removed[neighbor]) continue;
+      const double weight = nbrWeight_[j];
+      if (weight > 0)
+        inWeightSum[neighbor] -= weight;  // edge selection -> neighbor
+      else
+        outWeightSum[neighbor] += weight;  // edge neighbor -> selection
+    }
   }
   return ordering;
 }
@@ -142,30 +323,49 @@ map<MFAS::KeyPair, double> MFAS::computeOutlierWeights() const {
   // Find the ordering.
   KeyVector ordering = computeOrdering();
 
-  // Create a map from the node key to its position in the ordering. This makes
-  // it easier to lookup positions of different nodes.
-  unordered_map<Key, int> orderingPositions;
+  // Position of every node in the ordering, indexed by dense node id. This
+  // makes it easier to lookup positions of different nodes.
+  vector<size_t> orderingPositions(nodes_.size());
   for (size_t i = 0; i < ordering.size(); i++) {
-    orderingPositions[ordering[i]] = i;
+    orderingPositions[nodeIndex(ordering[i])] = i;
   }
 
-  map<KeyPair, double> outlierWeights;
   // Check if the direction of each edge is consistent with the ordering.
-  for (const auto& edgeWeight : edgeWeights_) {
-    // Find edge source and destination.
-    Key source = edgeWeight.first.first;
-    Key dest = edgeWeight.first.second;
-    if (edgeWeight.second < 0) {
-      std::swap(source, dest);
-    }
+  // Every edge is independent of the others, so this is an embarrassingly
+  // parallel scan over the flat edge arrays.
+  const size_t numEdges = edgeKeys_.size();
+  vector<double> outliers(numEdges);
+  auto checkEdge = [&](size_t i) {
+    // The edge arrays are in canonical direction, so source and destination
+    // come straight from the packed key and the weight is its magnitude.
+    const KeyPair edge = unpackKey(edgeKeys_[i]);
+    const size_t source = nodeIndex(edge.first);
+    const size_t dest = nodeIndex(edge.second);
 
     // If the direction is not consistent with the ordering (i.e dest occurs
     // before src), it is an outlier edge, and has non-zero outlier weight.
-    if (orderingPositions.at(dest) < orderingPositions.at(source)) {
-      outlierWeights[edgeWeight.first] = std::abs(edgeWeight.second);
-    } else {
-      outlierWeights[edgeWeight.first] = 0;
-    }
+    outliers[i] = orderingPositions[dest] < orderingPositions[source]
+                      ? edgeWeights_[i]
+                      : 0;
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numEdges),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); i++)
+                        checkEdge(i);
+                    });
+#else
+  for (size_t i = 0; i < numEdges; i++) checkEdge(i);
+#endif
+
+  // Convert to the map-based public result at the boundary only, undoing
+  // the canonical flip so the keys match the caller's original pairs. This
+  // is the one place the cold flipped_ array is read.
+  map<KeyPair, double> outlierWeights;
+  for (size_t i = 0; i < numEdges; i++) {
+    KeyPair edge = unpackKey(edgeKeys_[i]);
+    if (flipped_[i]) std::swap(edge.first, edge.second);
+    outlierWeights[edge] = outliers[i];
   }
   return outlierWeights;
 }
@@ -22,8 +22,14 @@
 #include <gtsam/inference/Key.h>
 #include <gtsam/sfm/BinaryMeasurement.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace gtsam {
@@ -55,25 +61,98 @@ class GTSAM_EXPORT MFAS {
   using KeyPair = std::pair<Key, Key>;
   using TranslationEdges = std::vector<BinaryMeasurement<Unit3>>;
 
+  /// A KeyPair packed into a single integer, (key1 << 32) | key2.
+  /// Comparing or hashing a packed key is one instruction, where the
+  /// lexicographic std::pair comparison is a branchy two-step; the packed
+  /// order coincides with the lexicographic order of the pairs.
+  using PackedKey = std::uint64_t;
+
+  /// Pack a key pair. MFAS nodes are cameras, whose keys are small in
+  /// practice; keys that do not fit in 32 bits cannot be packed and are
+  /// rejected here.
+  static PackedKey packKey(Key key1, Key key2) {
+    if (key1 >= (1ull << 32) || key2 >= (1ull << 32))
+      throw std::invalid_argument(
+          "MFAS::packKey: keys must fit in 32 bits");
+    return (key1 << 32) | key2;
+  }
+
+  /// Recover the key pair from a packed key.
+  static KeyPair unpackKey(PackedKey packed) {
+    return {packed >> 32, packed & 0xffffffffull};
+  }
+
  private:
-  // edges with a direction such that all weights are positive
-  // i.e, edges that originally had negative weights are flipped
-  std::map<KeyPair, double> edgeWeights_;
+  // Edges in canonical direction: edges whose input weight was negative are
+  // flipped, so edgeKeys_[i] packs (source, destination) and edgeWeights_[i]
+  // is always the positive weight magnitude. Stored as two parallel arrays
+  // sorted by packed key, so passes that only need the weights (or only the
+  // keys) stream one densely packed array instead of half-using cache lines
+  // of interleaved (key pair, weight) records. These two arrays are the hot
+  // data: the ordering and outlier scans read nothing else per edge.
+  std::vector<PackedKey> edgeKeys_;
+  std::vector<double> edgeWeights_;
+
+  // Cold per-edge metadata, kept out of the hot arrays above: whether edge i
+  // was flipped into canonical direction. Only consulted when translating
+  // back to the caller's key pairs in computeOutlierWeights' result map.
+  std::vector<std::uint8_t> flipped_;
+
+  // Dense node table and compressed-sparse-row (CSR) adjacency, built once
+  // at construction. nodes_ is sorted by key and the position of a key in it
+  // is its dense node id. Row v of the CSR lists every edge incident to node
+  // v: nbrIdx_[j] is the other endpoint's id and nbrWeight_[j] the magnitude
+  // of the edge weight, positive if the edge leaves v and negative if it
+  // enters v. computeOrdering updates per-node accumulators from one CSR row
+  // per removed node instead of re-scanning the whole edge list.
+  //
+  // The CSR rows are not in key order but in a reverse Cuthill-McKee order,
+  // so that graph neighbors get nearby ids and the per-node accumulator
+  // updates in computeOrdering touch nearby array entries. csrIndex_ maps a
+  // node id to its CSR id and csrToNode_ is the inverse.
+  KeyVector nodes_;
+  std::vector<size_t> rowPtr_;
+  std::vector<std::uint32_t> nbrIdx_;
+  std::vector<double> nbrWeight_;
+  std::vector<std::uint32_t> csrIndex_;
+  std::vector<std::uint32_t> csrToNode_;
+
+  /// Canonicalize, sort and split the (packed key, signed weight) edges into
+  /// the parallel edge arrays, then build the graph.
+  void setEdges(std::vector<std::pair<PackedKey, double>> edges);
+
+  /// Build nodes_ and the CSR adjacency from the sorted edge arrays.
+  void buildGraph();
+
+  /// Dense node id of a key, a binary search in the sorted node table.
+  size_t nodeIndex(Key key) const {
+    return std::distance(nodes_.begin(),
+                         std::lower_bound(nodes_.begin(), nodes_.end(), key));
+  }
 
  public:
   /**
    * @brief Construct from the weighted directed edges
    * between the nodes. Each node is identified by a Key.
+   * Keys must fit in 32 bits (see packKey); in particular Symbol-style keys,
+   * which use the high bits, are rejected with std::invalid_argument.
    * @param edgeWeights: weights of edges in the graph
    */
-  MFAS(const std::map<KeyPair, double> &edgeWeights)
-      : edgeWeights_(edgeWeights) {}
+  MFAS(const std::map<KeyPair, double> &edgeWeights) {
+    std::vector<std::pair<PackedKey, double>> edges;
+    edges.reserve(edgeWeights.size());
+    for (const auto &[edge, weight] : edgeWeights)
+      edges.emplace_back(packKey(edge.first, edge.second), weight);
+    setEdges(std::move(edges));
+  }
 
   /**
    * @brief Constructor to be used in the context of translation averaging.
    * Here, the nodes of the graph are cameras in 3D and the edges have a unit
    * translation direction between them. The weights of the edges is computed by
    * projecting them along a projection direction.
+   * Keys must fit in 32 bits (see packKey); in particular Symbol-style keys,
+   * which use the high bits, are rejected with std::invalid_argument.
    * @param relativeTranslations translation directions between the cameras
    * @param projectionDirection direction in which edges are to be projected
    */
@@ -96,6 +96,21 @@ TEST(MFAS, OrderingWeights1) {
   }
 }
 
+// test that key pairs round-trip through the packed representation and that
+// keys too large for it are rejected, also through the public constructor
+TEST(MFAS, PackedKeys) {
+  const MFAS::KeyPair edge = make_pair(Key(3), Key(100));
+  EXPECT(MFAS::unpackKey(MFAS::packKey(edge.first, edge.second)) == edge);
+
+  // keys must fit in 32 bits - e.g. Symbol keys, which use the high bits,
+  // cannot be packed
+  const Key tooLarge = Key(1) << 32;
+  CHECK_EXCEPTION(MFAS::packKey(tooLarge, Key(0)), invalid_argument);
+  CHECK_EXCEPTION(MFAS::packKey(Key(0), tooLarge), invalid_argument);
+  map<MFAS::KeyPair, double> edgeWeights = {{{tooLarge, Key(0)}, 1.0}};
+  CHECK_EXCEPTION(MFAS mfas_obj(edgeWeights), invalid_argument);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
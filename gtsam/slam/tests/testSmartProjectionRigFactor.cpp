@@ -1346,7 +1346,7 @@ TEST(SmartProjectionFactorP, timing_sphericalCamera) {
   static Cal3_S2::shared_ptr sharedKSimple(new Cal3_S2(100, 100, 0, 0, 0));
   PinholePose<Cal3_S2> cam1(pose1, sharedKSimple), cam2(pose2, sharedKSimple);
   // Project 2 landmarks into 2 cameras
-  std::vector<Point2> measurements_lmk1;
+  Point2Vector measurements_lmk1;
   measurements_lmk1.push_back(cam1.project(landmark1));
   measurements_lmk1.push_back(cam2.project(landmark1));
 